@@ -0,0 +1,211 @@
+/*
+  ==============================================================================
+
+	Peak, true peak, RMS and BS.1770 loudness metering for the processor's
+	input and output.
+
+  ==============================================================================
+*/
+
+#include "LevelMeter.h"
+#include "PluginProcessor.h"
+
+namespace
+{
+	/*the two k-weighting stages from BS.1770, a high shelf for the head and a highpass. the
+	spec only lists 48kHz coefficients so these are the analog designs redone for any rate,
+	with libebur128's constants. like the spec and libebur128, only the shelf's numerator is
+	normalised, the highpass keeps b = 1, -2, 1.*/
+	Coefficients makeKWeightingShelf(double sampleRate)
+	{
+		const double f0 = 1681.974450955533, gainDb = 3.999843853973347, q = 0.7071752369554196;
+		auto k = std::tan(juce::MathConstants<double>::pi * f0 / sampleRate);
+		auto vh = std::pow(10.0, gainDb / 20.0);
+		auto vb = std::pow(vh, 0.4996667741545416);
+		return new juce::dsp::IIR::Coefficients<float>(float(vh + vb * k / q + k * k),
+													   float(2.0 * (k * k - vh)),
+													   float(vh - vb * k / q + k * k),
+													   float(1.0 + k / q + k * k),
+													   float(2.0 * (k * k - 1.0)),
+													   float(1.0 - k / q + k * k));
+	}
+
+	Coefficients makeKWeightingHighPass(double sampleRate)
+	{
+		const double f0 = 38.13547087602444, q = 0.5003270373238773;
+		auto k = std::tan(juce::MathConstants<double>::pi * f0 / sampleRate);
+		//juce divides everything by a0, so the numerator goes in times a0 to come out as 1, -2, 1
+		auto a0 = 1.0 + k / q + k * k;
+		return new juce::dsp::IIR::Coefficients<float>(float(a0), float(-2.0 * a0), float(a0),
+													   float(a0),
+													   float(2.0 * (k * k - 1.0)),
+													   float(1.0 - k / q + k * k));
+	}
+
+	//split over four accumulators so the compiler can keep them in one vector register
+	double sumOfSquares(const float* data, int numSamples)
+	{
+		float acc[4] = { 0.f, 0.f, 0.f, 0.f };
+		int i = 0;
+		for (; i + 4 <= numSamples; i += 4)
+		{
+			acc[0] += data[i] * data[i];
+			acc[1] += data[i + 1] * data[i + 1];
+			acc[2] += data[i + 2] * data[i + 2];
+			acc[3] += data[i + 3] * data[i + 3];
+		}
+		for (; i < numSamples; ++i)
+			acc[0] += data[i] * data[i];
+		return double(acc[0]) + double(acc[1]) + double(acc[2]) + double(acc[3]);
+	}
+
+	float absolutePeak(const float* data, int numSamples)
+	{
+		auto range = juce::FloatVectorOperations::findMinAndMax(data, numSamples);
+		return juce::jmax(-range.getStart(), range.getEnd());
+	}
+
+	void storeMax(std::atomic<float>& target, float value)
+	{
+		auto previous = target.load();
+		while (value > previous && !target.compare_exchange_weak(previous, value))
+		{
+		}
+	}
+
+	float toLufs(double meanSquare)
+	{
+		return meanSquare > 1.0e-10 ? float(-0.691 + 10.0 * std::log10(meanSquare)) : -100.f;
+	}
+}
+
+//==============================================================================
+void MeterReadings::clear()
+{
+	samplePeak.store(0.f);
+	truePeak.store(0.f);
+	rms.store(0.f);
+	momentaryLufs.store(-100.f);
+	shortTermLufs.store(-100.f);
+}
+
+//==============================================================================
+void LevelMeter::prepare(double sampleRate, int maximumBlockSize, int numChannels)
+{
+	maxBlockSize = juce::jmax(1, maximumBlockSize);
+	numMeteredChannels = juce::jmax(1, numChannels);
+	binLength = juce::jmax(1, juce::roundToInt(0.1 * sampleRate));
+
+	juce::dsp::ProcessSpec spec;
+	spec.maximumBlockSize = maxBlockSize;
+	spec.numChannels = 1;
+	spec.sampleRate = sampleRate;
+	kWeighting.resize(numMeteredChannels);
+	auto shelf = makeKWeightingShelf(sampleRate);
+	auto highPass = makeKWeightingHighPass(sampleRate);
+	for (auto& chain : kWeighting)
+	{
+		chain.prepare(spec);
+		updateCoeffs(chain.get<0>(), *shelf);
+		updateCoeffs(chain.get<1>(), *highPass);
+	}
+
+	//4x, the polyphase iir halfbands are the cheap option and plenty for peak detection
+	oversampler = std::make_unique<juce::dsp::Oversampling<float>>(
+		numMeteredChannels, 2, juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR, false);
+	oversampler->initProcessing(maxBlockSize);
+
+	weighted.setSize(numMeteredChannels, maxBlockSize);
+	reset();
+}
+
+void LevelMeter::reset()
+{
+	for (auto& chain : kWeighting)
+		chain.reset();
+	if (oversampler != nullptr)
+		oversampler->reset();
+	weightedBins.fill(0.0);
+	flatBins.fill(0.0);
+	weightedSum = flatSum = 0.0;
+	binFill = nextBin = filledBins = 0;
+	readings.clear();
+}
+
+void LevelMeter::process(const juce::AudioBuffer<float>& buffer)
+{
+	//hosts are allowed to go over the block size they prepared us with, so chop it up
+	for (int start = 0; start < buffer.getNumSamples(); start += maxBlockSize)
+		processChunk(buffer, start, juce::jmin(maxBlockSize, buffer.getNumSamples() - start));
+}
+
+void LevelMeter::processChunk(const juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+	auto numChannels = juce::jmin(buffer.getNumChannels(), numMeteredChannels);
+	if (numChannels <= 0 || numSamples <= 0)
+		return;
+
+	//sample peak, and k-weight a copy of each channel for the loudness sums
+	float peak = 0.f;
+	for (int ch = 0; ch < numChannels; ++ch)
+	{
+		auto* input = buffer.getReadPointer(ch, startSample);
+		peak = juce::jmax(peak, absolutePeak(input, numSamples));
+
+		weighted.copyFrom(ch, 0, input, numSamples);
+		auto weightedBlock = juce::dsp::AudioBlock<float>(weighted).getSingleChannelBlock(ch)
+			.getSubBlock(0, (size_t)numSamples);
+		kWeighting[ch].process(juce::dsp::ProcessContextReplacing<float>(weightedBlock));
+	}
+
+	//true peak, the interpolated signal can only add overs between samples
+	juce::dsp::AudioBlock<const float> inputBlock(buffer.getArrayOfReadPointers(), (size_t)numChannels,
+												  (size_t)startSample, (size_t)numSamples);
+	auto upsampled = oversampler->processSamplesUp(inputBlock);
+	float truePeak = peak;
+	for (size_t ch = 0; ch < upsampled.getNumChannels(); ++ch)
+		truePeak = juce::jmax(truePeak, absolutePeak(upsampled.getChannelPointer(ch), (int)upsampled.getNumSamples()));
+
+	storeMax(readings.samplePeak, peak);
+	storeMax(readings.truePeak, truePeak);
+
+	//fill up the 100ms bins, publishing loudness every time one completes
+	int position = 0;
+	while (position < numSamples)
+	{
+		auto count = juce::jmin(numSamples - position, binLength - binFill);
+		for (int ch = 0; ch < numChannels; ++ch)
+		{
+			weightedSum += sumOfSquares(weighted.getReadPointer(ch, position), count);
+			flatSum += sumOfSquares(buffer.getReadPointer(ch, startSample + position), count);
+		}
+		position += count;
+		binFill += count;
+		if (binFill == binLength)
+			finishBin();
+	}
+}
+
+void LevelMeter::finishBin()
+{
+	weightedBins[nextBin] = weightedSum;
+	flatBins[nextBin] = flatSum;
+	nextBin = (nextBin + 1) % numBins;
+	filledBins = juce::jmin(filledBins + 1, numBins);
+	weightedSum = flatSum = 0.0;
+	binFill = 0;
+
+	//until the windows have filled up we average over what we have
+	auto sumLast = [this](const std::array<double, numBins>& bins, int count)
+	{
+		double total = 0.0;
+		for (int i = 1; i <= count; ++i)
+			total += bins[(nextBin - i + numBins) % numBins];
+		return total;
+	};
+	auto momentaryCount = juce::jmin(filledBins, momentaryBins);
+	auto momentaryLength = double(momentaryCount) * binLength;
+	readings.momentaryLufs.store(toLufs(sumLast(weightedBins, momentaryCount) / momentaryLength));
+	readings.shortTermLufs.store(toLufs(sumLast(weightedBins, filledBins) / (double(filledBins) * binLength)));
+	readings.rms.store(float(std::sqrt(sumLast(flatBins, momentaryCount) / (momentaryLength * numMeteredChannels))));
+}
@@ -0,0 +1,59 @@
+/*
+  ==============================================================================
+
+	Peak, true peak, RMS and BS.1770 loudness metering for the processor's
+	input and output.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/*this is everything the editor gets to see. the audio thread writes and the message thread
+reads, atomics only so there's no locking either side. the peaks are the highest value since
+the editor last took them (takePeak swaps them back to zero) so nothing gets missed between
+repaints, the rest are just the latest values.*/
+struct MeterReadings
+{
+	std::atomic<float> samplePeak{ 0.f }, truePeak{ 0.f };
+	std::atomic<float> rms{ 0.f };
+	std::atomic<float> momentaryLufs{ -100.f }, shortTermLufs{ -100.f };
+
+	static float takePeak(std::atomic<float>& peak) { return peak.exchange(0.f); }
+	void clear();
+};
+
+/*one of these sits on the input and one on the output. loudness is worked out the way
+BS.1770 does it, k-weighted mean square summed over the channels, but we keep it in 100ms
+bins so the 400ms momentary and 3s short term windows are just sums over the last 4 and 30
+bins. the k-weighting is two of juce's biquads in a processor chain, same as our eq stages,
+and true peak comes from 4x oversampling the block. everything is allocated in prepare().*/
+class LevelMeter
+{
+public:
+	void prepare(double sampleRate, int maximumBlockSize, int numChannels);
+	void reset();
+	//only reads the buffer, the audio passes through untouched
+	void process(const juce::AudioBuffer<float>& buffer);
+
+	MeterReadings readings;
+
+private:
+	void processChunk(const juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+	void finishBin();
+
+	using KWeighting = juce::dsp::ProcessorChain<juce::dsp::IIR::Filter<float>, juce::dsp::IIR::Filter<float>>;
+	static constexpr int numBins = 30, momentaryBins = 4;
+
+	std::vector<KWeighting> kWeighting;
+	std::unique_ptr<juce::dsp::Oversampling<float>> oversampler;
+	juce::AudioBuffer<float> weighted;
+	int maxBlockSize{ 0 }, numMeteredChannels{ 0 };
+
+	//sums of squares per 100ms bin, k-weighted for loudness and flat for rms
+	std::array<double, numBins> weightedBins{}, flatBins{};
+	double weightedSum{ 0 }, flatSum{ 0 };
+	int binLength{ 1 }, binFill{ 0 }, nextBin{ 0 }, filledBins{ 0 };
+};
@@ -9,22 +9,52 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 
-ResponseCurveDraw::ResponseCurveDraw(MyEQAudioProcessor& p) : audioProcessor(p)
+ResponseCurveDraw::ResponseCurveDraw(MyEQAudioProcessor& p)
+	: juce::ComponentMovementWatcher(this), audioProcessor(p)
 {
-	//range based for loop to add listeners to all dials
-	const auto& params = audioProcessor.getParameters();
-	for (auto param : params)
-		param->addListener(this);
-	startTimerHz(60);
+	//nothing to do until we're shown, see setActive()
 }
 
 ResponseCurveDraw::~ResponseCurveDraw()
 {
-	//range based for loop to destruct listeners
+	setActive(false);
+}
+
+void ResponseCurveDraw::setActive(bool shouldBeActive)
+{
+	if (active == shouldBeActive)
+		return;
+	active = shouldBeActive;
+
+	//range based for loops to add or remove listeners on all dials
 	const auto& params = audioProcessor.getParameters();
-	for (auto param : params)
-		param->removeListener(this);
+	if (active)
+	{
+		for (auto param : params)
+			param->addListener(this);
+		/*anything could have changed while we were hidden, the next tick rebuilds the curve and
+		repaints. doing it here would repaint from inside paint() when that's what woke us*/
+		paramsChanged.set(true);
+		startTimerHz(60);
+	}
+	else
+	{
+		stopTimer();
+		for (auto param : params)
+			param->removeListener(this);
+	}
+}
+
+void ResponseCurveDraw::componentPeerChanged()
+{
+	setActive(isShowing());
 }
+
+void ResponseCurveDraw::componentVisibilityChanged()
+{
+	setActive(isShowing());
+}
+
 void ResponseCurveDraw::parameterValueChanged(int parameterIndex, float newValue)
 {
 	//listener!
@@ -33,80 +63,166 @@ void ResponseCurveDraw::parameterValueChanged(int parameterIndex, float newValue
 
 void ResponseCurveDraw::timerCallback()
 {
+	/*minimising the host window doesn't tell us anything, so check here and go quiet,
+	paint() picks us back up when we get drawn again*/
+	if (!isShowing())
+	{
+		setActive(false);
+		return;
+	}
 	//test switch for true and then set to false
 	if (paramsChanged.compareAndSetBool(false, true))
 	{
-		auto eqSettings = getEqSettings(audioProcessor.parameters);
-		//graphic representation for peak
-		auto peakCoeffs = makePeakFilter(eqSettings, audioProcessor.getSampleRate());
-		updateCoeffs(monoChain.get<eqTypes::Peak>().coefficients, peakCoeffs);
-		//graphic representation for lowcut
-		auto lowCutCoeffs = makeLowCutFilter(eqSettings, audioProcessor.getSampleRate());
-		auto highCutCoeffs = makeHighCutFilter(eqSettings, audioProcessor.getSampleRate());
-		updateCutFilters(monoChain.get<eqTypes::LowCut>(), lowCutCoeffs, eqSettings.lowCutSlope);
-		updateCutFilters(monoChain.get<eqTypes::HighCut>(), highCutCoeffs, eqSettings.highCutSlope);
+		updateResponseCurve();
 		repaint();
 	}
 }
-void ResponseCurveDraw::paint(juce::Graphics& g)
+
+void ResponseCurveDraw::resized()
+{
+	if (active)
+		updateResponseCurve();
+}
+
+void ResponseCurveDraw::updateResponseCurve()
 {
 	//bring everything necessary into scope or into variables into scope
 	auto responseArea = getLocalBounds();
 	auto responseWidth = responseArea.getWidth();
-	auto& lowCut = monoChain.get < eqTypes::LowCut>();
-	auto& peak = monoChain.get < eqTypes::Peak>();
-	auto& highCut = monoChain.get < eqTypes::HighCut>();
 	auto sampleRate = audioProcessor.getSampleRate();
+	responseCurve.clear();
+	if (responseWidth <= 0)
+		return;
 
-	std::vector<double> mags;
-	mags.resize(responseWidth);
-	/*get magnitudes of our filter coefficients, we use the maptolog10 so the response
-	curve is drawn proportional to how frequency is percieved by us.*/
-	for (int i = 0; i < mags.size(); ++i)
+	/*we use the maptolog10 so the response curve is drawn proportional to how frequency
+	is percieved by us.*/
+	std::vector<double> freqs(responseWidth), mags(responseWidth, 1.0), stageMags(responseWidth);
+	for (int i = 0; i < responseWidth; ++i)
+		freqs[i] = juce::mapToLog10(double(i) / double(responseWidth), 20.0, 20000.0);
+
+	/*get magnitudes of our filter coefficients straight from the filter designs, every
+	active stage is multiplied in. before the host has prepared us there's no sample rate,
+	so the curve just stays flat.*/
+	if (sampleRate > 0)
 	{
-		double mag = 1.f;
-		auto freq = juce::mapToLog10(double(i) / double(responseWidth), 20.0, 20000.0);
-		if (!monoChain.isBypassed<eqTypes::Peak>())
-			mag *= peak.coefficients->getMagnitudeForFrequency(freq, sampleRate);
-		if (!lowCut.isBypassed<0>())
-			mag *= lowCut.get<0>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-		if (!lowCut.isBypassed<1>())
-			mag *= lowCut.get<1>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-		if (!lowCut.isBypassed<2>())
-			mag *= lowCut.get<2>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-		if (!lowCut.isBypassed<3>())
-			mag *= lowCut.get<3>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-		if (!highCut.isBypassed<0>())
-			mag *= highCut.get<0>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-		if (!highCut.isBypassed<1>())
-			mag *= highCut.get<1>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-		if (!highCut.isBypassed<2>())
-			mag *= highCut.get<2>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-		if (!highCut.isBypassed<3>())
-			mag *= highCut.get<3>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-		mags[i] = juce::Decibels::gainToDecibels(mag);
+		auto eqSettings = getEqSettings(audioProcessor.parameters);
+		auto applyStage = [&](const juce::dsp::IIR::Coefficients<float>& coeffs)
+		{
+			coeffs.getMagnitudeForFrequencyArray(freqs.data(), stageMags.data(), freqs.size(), sampleRate);
+			for (int i = 0; i < responseWidth; ++i)
+				mags[i] *= stageMags[i];
+		};
+		applyStage(*makePeakFilter(eqSettings, sampleRate));
+		for (auto* coeffs : makeLowCutFilter(eqSettings, sampleRate))
+			applyStage(*coeffs);
+		for (auto* coeffs : makeHighCutFilter(eqSettings, sampleRate))
+			applyStage(*coeffs);
 	}
 
 	/*here we use the juce::Path class to draw our response curve, this class allows us to plot
 	points for to draw a line, here we use all the individual magnitudes and draw a line for the
 	response curve to be represented by*/
-	juce::Path responseCurve;
 	const double outMin = responseArea.getBottom();
 	const double outMax = responseArea.getY();
 	auto map = [outMin, outMax](double input) {return juce::jmap(input, -24.0, 24.0,
 																 outMin, outMax); };
-	responseCurve.startNewSubPath(responseArea.getX(), map(mags.front()));
+	responseCurve.startNewSubPath(responseArea.getX(), map(juce::Decibels::gainToDecibels(mags.front())));
 
 	for (size_t i = 1; i < mags.size(); ++i)
-		responseCurve.lineTo(responseArea.getX() + i, map(mags[i]));
+		responseCurve.lineTo(responseArea.getX() + i, map(juce::Decibels::gainToDecibels(mags[i])));
+}
 
+void ResponseCurveDraw::paint(juce::Graphics& g)
+{
+	//if we're being drawn we're on screen again, e.g. after the host window was minimised
+	if (!active && isShowing())
+		setActive(true);
 
+	auto responseArea = getLocalBounds();
 	g.setColour(juce::Colours::orange);
 	g.drawRoundedRectangle(responseArea.toFloat(), 4.f, 1.f);
 	g.setColour(juce::Colours::white);
 	g.strokePath(responseCurve, juce::PathStrokeType(2.f));
 }
 //==============================================================================
+MeterReadout::MeterReadout(MyEQAudioProcessor& p)
+	: juce::ComponentMovementWatcher(this), audioProcessor(p)
+{
+}
+
+void MeterReadout::componentPeerChanged()
+{
+	updateActivity();
+}
+
+void MeterReadout::componentVisibilityChanged()
+{
+	updateActivity();
+}
+
+void MeterReadout::updateActivity()
+{
+	if (isShowing())
+		startTimerHz(10);
+	else
+		stopTimer();
+}
+
+MeterReadout::Snapshot MeterReadout::takeSnapshot(MeterReadings& readings)
+{
+	Snapshot snapshot;
+	snapshot.samplePeak = MeterReadings::takePeak(readings.samplePeak);
+	snapshot.truePeak = MeterReadings::takePeak(readings.truePeak);
+	snapshot.rms = readings.rms.load();
+	snapshot.momentaryLufs = readings.momentaryLufs.load();
+	snapshot.shortTermLufs = readings.shortTermLufs.load();
+	return snapshot;
+}
+
+void MeterReadout::timerCallback()
+{
+	if (!isShowing())
+	{
+		stopTimer();
+		return;
+	}
+	input = takeSnapshot(audioProcessor.inputMeter.readings);
+	output = takeSnapshot(audioProcessor.outputMeter.readings);
+	repaint();
+}
+
+void MeterReadout::paint(juce::Graphics& g)
+{
+	/*minimising the host window doesn't change our peer or visibility, so nothing else would
+	restart the timer once it has stopped itself. being drawn means we're back on screen*/
+	if (!isTimerRunning() && isShowing())
+		startTimerHz(10);
+
+	//one line each for input and output, levels in dBFS and loudness in LUFS
+	auto decibels = [](float gain)
+	{
+		auto db = juce::Decibels::gainToDecibels(gain, -100.f);
+		return db <= -100.f ? juce::String("-inf") : juce::String(db, 1);
+	};
+	auto lufs = [](float value)
+	{
+		return value <= -100.f ? juce::String("-inf") : juce::String(value, 1);
+	};
+	auto describe = [&](const juce::String& name, const Snapshot& s)
+	{
+		return name + "  peak " + decibels(s.samplePeak) + "  tp " + decibels(s.truePeak)
+			+ "  rms " + decibels(s.rms) + " dB    M " + lufs(s.momentaryLufs)
+			+ "  S " + lufs(s.shortTermLufs) + " LUFS";
+	};
+
+	auto bounds = getLocalBounds();
+	g.setColour(juce::Colours::white);
+	g.setFont(12.f);
+	g.drawText(describe("IN ", input), bounds.removeFromTop(bounds.getHeight() / 2),
+			   juce::Justification::centredLeft);
+	g.drawText(describe("OUT", output), bounds, juce::Justification::centredLeft);
+}
+//==============================================================================
 MyEQAudioProcessorEditor::MyEQAudioProcessorEditor(MyEQAudioProcessor& p)
 	: AudioProcessorEditor(&p), audioProcessor(p),
 	responseCurve(audioProcessor),
@@ -116,24 +232,28 @@ MyEQAudioProcessorEditor::MyEQAudioProcessorEditor(MyEQAudioProcessor& p)
 	lowCutFreqSliderAttatchment(audioProcessor.parameters, "LowCut Freq", lowCutFreqSlider),
 	lowCutSlopeSliderAttatchment(audioProcessor.parameters, "LowCut Slope", lowCutSlopeSlider),
 	highCutSlopeSliderAttatchment(audioProcessor.parameters, "HighCut Slope", highCutSlopeSlider),
-	highCutFreqSliderAttatchment(audioProcessor.parameters, "HighCut Freq", highCutFreqSlider)
+	highCutFreqSliderAttatchment(audioProcessor.parameters, "HighCut Freq", highCutFreqSlider),
+	meterReadout(audioProcessor),
+	metersOnButtonAttatchment(audioProcessor.parameters, "Meters On", metersOnButton)
 {
 	//push gui members to graphics rendering thread
 	addAndMakeVisible(responseCurve);
+	addAndMakeVisible(meterReadout);
+	addAndMakeVisible(metersOnButton);
 	addAndMakeVisible(peakFreqSlider);
-	peakFreqSlider.setLookAndFeel(&peakDials);
+	peakFreqSlider.setLookAndFeel(&dialLooks->peakDials);
 	addAndMakeVisible(peakGainSlider);
-	peakGainSlider.setLookAndFeel(&peakDials);
+	peakGainSlider.setLookAndFeel(&dialLooks->peakDials);
 	addAndMakeVisible(peakQSlider);
-	peakQSlider.setLookAndFeel(&peakDials);
+	peakQSlider.setLookAndFeel(&dialLooks->peakDials);
 	addAndMakeVisible(lowCutFreqSlider);
-	lowCutFreqSlider.setLookAndFeel(&lowDials);
+	lowCutFreqSlider.setLookAndFeel(&dialLooks->lowDials);
 	addAndMakeVisible(highCutFreqSlider);
-	highCutFreqSlider.setLookAndFeel(&highDials);
+	highCutFreqSlider.setLookAndFeel(&dialLooks->highDials);
 	addAndMakeVisible(lowCutSlopeSlider);
-	lowCutSlopeSlider.setLookAndFeel(&lowDials);
+	lowCutSlopeSlider.setLookAndFeel(&dialLooks->lowDials);
 	addAndMakeVisible(highCutSlopeSlider);
-	highCutSlopeSlider.setLookAndFeel(&highDials);
+	highCutSlopeSlider.setLookAndFeel(&dialLooks->highDials);
 
 
 	setSize(800, 600);
@@ -157,6 +277,10 @@ void MyEQAudioProcessorEditor::resized()
 	auto responseArea = bounds.removeFromTop(bounds.getHeight() * 0.33);
 	responseCurve.setBounds(responseArea);
 
+	auto meterArea = bounds.removeFromTop(36);
+	metersOnButton.setBounds(meterArea.removeFromLeft(80));
+	meterReadout.setBounds(meterArea);
+
 	auto lowCutArea = bounds.removeFromLeft(bounds.getWidth() * 0.33);
 	auto highCutArea = bounds.removeFromRight(bounds.getWidth() * 0.5);
 
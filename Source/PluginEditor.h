@@ -63,6 +63,18 @@ private:
 	juce::Colour colour2;
 };
 //==============================================================================
+/*the dials' look and feels don't hold any per editor state, so rather than every editor that
+gets opened building its own three LookAndFeel_V4s (each fills in a whole colour scheme) they
+all share one set through a SharedResourcePointer, made with the first editor and gone with
+the last*/
+struct DialLooks
+{
+	GuiStyleSheet guiStyleSheet;
+	CustomDial lowDials{ guiStyleSheet.l1, guiStyleSheet.l2 };
+	CustomDial peakDials{ guiStyleSheet.p1, guiStyleSheet.p2 };
+	CustomDial highDials{ guiStyleSheet.h1, guiStyleSheet.h2 };
+};
+//==============================================================================
 struct CustomSlider : juce::Slider
 {
 	CustomSlider() : juce::Slider(juce::Slider::SliderStyle::RotaryHorizontalVerticalDrag,
@@ -71,22 +83,68 @@ struct CustomSlider : juce::Slider
 	}
 };
 //==============================================================================
+/*the response curve only listens to the parameters and runs its timer while it is actually
+on screen. the component movement watcher tells us when we (or any parent) get shown, hidden
+or moved to another window, so a hidden editor costs nothing. the curve itself is worked out
+once per change into a path, paint just strokes it.*/
 struct ResponseCurveDraw : juce::Component,
 	juce::AudioProcessorParameter::Listener,
-	juce::Timer
+	juce::Timer,
+	juce::ComponentMovementWatcher
 {
 	ResponseCurveDraw(MyEQAudioProcessor&);
 	~ResponseCurveDraw();
 	//==============================================================================
-	void paint(juce::Graphics& g);
+	void paint(juce::Graphics& g) override;
+	void resized() override;
 	//==============================================================================
 	void timerCallback() override;
 	void parameterValueChanged(int parameterIndex, float newValue) override;
 	void parameterGestureChanged(int parameterIndex, bool gestureIsStarting) override {};
+	//==============================================================================
+	//the watcher's own overloads, not the ComponentListener ones these would otherwise hide
+	using juce::ComponentMovementWatcher::componentMovedOrResized;
+	using juce::ComponentMovementWatcher::componentVisibilityChanged;
+	void componentMovedOrResized(bool wasMoved, bool wasResized) override {};
+	void componentPeerChanged() override;
+	void componentVisibilityChanged() override;
 private:
+	void setActive(bool shouldBeActive);
+	void updateResponseCurve();
+
 	MyEQAudioProcessor& audioProcessor;
 	juce::Atomic<bool> paramsChanged{ false };
-	MonoChain monoChain;
+	bool active{ false };
+	juce::Path responseCurve;
+};
+//==============================================================================
+/*text readout for the input and output meters. like the response curve it only polls the
+processor while it is on screen. peaks are taken (and reset) every tick, the rest are read.*/
+struct MeterReadout : juce::Component,
+	juce::Timer,
+	juce::ComponentMovementWatcher
+{
+	MeterReadout(MyEQAudioProcessor&);
+	//==============================================================================
+	void paint(juce::Graphics& g) override;
+	void timerCallback() override;
+	//==============================================================================
+	using juce::ComponentMovementWatcher::componentMovedOrResized;
+	using juce::ComponentMovementWatcher::componentVisibilityChanged;
+	void componentMovedOrResized(bool wasMoved, bool wasResized) override {};
+	void componentPeerChanged() override;
+	void componentVisibilityChanged() override;
+private:
+	struct Snapshot
+	{
+		float samplePeak{ 0.f }, truePeak{ 0.f }, rms{ 0.f };
+		float momentaryLufs{ -100.f }, shortTermLufs{ -100.f };
+	};
+	static Snapshot takeSnapshot(MeterReadings& readings);
+	void updateActivity();
+
+	MyEQAudioProcessor& audioProcessor;
+	Snapshot input, output;
 };
 //==============================================================================
 class MyEQAudioProcessorEditor : public juce::AudioProcessorEditor
@@ -100,6 +158,8 @@ public:
 	//==============================================================================
 private:
 	MyEQAudioProcessor& audioProcessor;
+	//before the sliders so it outlives them
+	juce::SharedResourcePointer<DialLooks> dialLooks;
 	CustomSlider lowCutFreqSlider,
 		highCutFreqSlider,
 		peakFreqSlider,
@@ -110,11 +170,7 @@ private:
 
 	using Parameters = juce::AudioProcessorValueTreeState;
 	using Attatchment = Parameters::SliderAttachment;
-
-	GuiStyleSheet guiStyleSheet;
-	CustomDial lowDials{ guiStyleSheet.l1, guiStyleSheet.l2 };
-	CustomDial peakDials{ guiStyleSheet.p1, guiStyleSheet.p2 };
-	CustomDial highDials{ guiStyleSheet.h1, guiStyleSheet.h2 };
+	using ButtonAttatchment = Parameters::ButtonAttachment;
 
 	Attatchment lowCutFreqSliderAttatchment,
 		highCutFreqSliderAttatchment,
@@ -125,7 +181,9 @@ private:
 		highCutSlopeSliderAttatchment;
 
 	ResponseCurveDraw responseCurve;
-	MonoChain monoChain;
+	MeterReadout meterReadout;
+	juce::ToggleButton metersOnButton{ "Meters" };
+	ButtonAttatchment metersOnButtonAttatchment;
 
 	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MyEQAudioProcessorEditor)
 };
@@ -99,6 +99,9 @@ void MyEQAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 	spec.sampleRate = sampleRate;
 	leftChain.prepare(spec);
 	rightChain.prepare(spec);
+	inputMeter.prepare(sampleRate, samplesPerBlock, getTotalNumInputChannels());
+	outputMeter.prepare(sampleRate, samplesPerBlock, getTotalNumOutputChannels());
+	metersWereOn = false;
 
 	//bring eq settings into scope
 	auto eqSettings = getEqSettings(parameters);
@@ -145,6 +148,18 @@ void MyEQAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::Mi
 	for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
 		buffer.clear(i, 0, buffer.getNumSamples());
 
+	/*metering can be switched off completely, then we skip it all. when it comes back on the
+	old loudness bins are stale so start again from scratch*/
+	auto metersOn = parameters.getRawParameterValue("Meters On")->load() > 0.5f;
+	if (metersOn != metersWereOn)
+	{
+		inputMeter.reset();
+		outputMeter.reset();
+		metersWereOn = metersOn;
+	}
+	if (metersOn)
+		inputMeter.process(buffer);
+
 	//bring users eq settings into scope
 	auto eqSettings = getEqSettings(parameters);
 
@@ -156,11 +171,18 @@ void MyEQAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::Mi
 	//output now produced audio block
 	juce::dsp::AudioBlock<float> block(buffer);
 	auto leftBlock = block.getSingleChannelBlock(0);
-	auto rightBlock = block.getSingleChannelBlock(1);
 	juce::dsp::ProcessContextReplacing<float> leftContext(leftBlock);
-	juce::dsp::ProcessContextReplacing<float> rightContext(rightBlock);
 	leftChain.process(leftContext);
-	rightChain.process(rightContext);
+	//mono layouts only have the one channel
+	if (block.getNumChannels() > 1)
+	{
+		auto rightBlock = block.getSingleChannelBlock(1);
+		juce::dsp::ProcessContextReplacing<float> rightContext(rightBlock);
+		rightChain.process(rightContext);
+	}
+
+	if (metersOn)
+		outputMeter.process(buffer);
 }
 
 //==============================================================================
@@ -238,6 +260,9 @@ juce::AudioProcessorValueTreeState::ParameterLayout MyEQAudioProcessor::createPa
 															"HighCut Slope",
 															stringArray,
 															0));
+	layout.add(std::make_unique<juce::AudioParameterBool>("Meters On",
+														  "Meters On",
+														  true));
 
 	return layout;
 }
@@ -246,9 +271,8 @@ void MyEQAudioProcessor::updatePeakFilter(EqSettings& settings)
 	/*for the next 3 functions i have written, when in preparetoplay() and processblock()
 	and the update filter functions are called, we call another function, declared in our header
 	file, coefficients for the IIR filters are generated, and then updated per the user's settings */
-	auto peakCoeffs = makePeakFilter(settings, getSampleRate());
-	updateCoeffs(*leftChain.get<eqTypes::Peak>().coefficients, *peakCoeffs);
-	updateCoeffs(*rightChain.get<eqTypes::Peak>().coefficients, *peakCoeffs);
+	updatePeakFilters({ &leftChain.get<eqTypes::Peak>(), &rightChain.get<eqTypes::Peak>() },
+					  settings, getSampleRate());
 }
 void MyEQAudioProcessor::updateLowCutFilter(EqSettings& settings)
 {
@@ -9,6 +9,9 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "TptFilter.h"
+#include "BlockBiquad.h"
+#include "LevelMeter.h"
 //here is a simple enum to store the different options for our cut filters
 enum Slope
 {
@@ -26,11 +29,41 @@ struct EqSettings
 	float peakGain{ 0 }, peakQ{ 1.f };
 	Slope lowCutSlope{ Slope::Slope_12 }, highCutSlope{ Slope::Slope_12 };
 };
+/*the chain is templated on the filter it is built from, so the topology is a policy. juce's
+IIR::Filter (direct form biquad) is the default, building with MYEQ_USE_TPT_FILTERS=1 swaps every
+stage for the state variable filter in TptFilter.h, which can be swept at audio rate, and
+MYEQ_USE_BLOCK_IIR_FILTERS=1 swaps them for BlockBiquad.h, which works out 8 samples per step
+and is the quick one for mono material. the "Release TPT" and "Release Block IIR" exporter
+configurations in myEQ.jucer set these. all of them run off the same coefficient designs below
+so they sound and draw the same.*/
+#ifndef MYEQ_USE_TPT_FILTERS
+ #define MYEQ_USE_TPT_FILTERS 0
+#endif
+#ifndef MYEQ_USE_BLOCK_IIR_FILTERS
+ #define MYEQ_USE_BLOCK_IIR_FILTERS 0
+#endif
+#if MYEQ_USE_TPT_FILTERS && MYEQ_USE_BLOCK_IIR_FILTERS
+ #error "MYEQ_USE_TPT_FILTERS and MYEQ_USE_BLOCK_IIR_FILTERS can't both be set, pick one topology"
+#endif
+template<typename FilterType>
+using CutFilterOf = juce::dsp::ProcessorChain<FilterType, FilterType, FilterType, FilterType>;
+template<typename FilterType>
+using MonoChainOf = juce::dsp::ProcessorChain<CutFilterOf<FilterType>, FilterType, CutFilterOf<FilterType>>;
+
 /*to make our code more brief we run using Filter etc... to save us writing all the code to gain
-access of the juce::dsp::IIR::Filter class, we did this also for cutfilter and monochain*/
-using Filter = juce::dsp::IIR::Filter<float>;
-using CutFilter = juce::dsp::ProcessorChain<Filter, Filter, Filter, Filter>;
-using MonoChain = juce::dsp::ProcessorChain<CutFilter, Filter, CutFilter>;
+access of the filter classes, we did this also for cutfilter and monochain*/
+using BiquadFilter = juce::dsp::IIR::Filter<float>;
+using SvfFilter = TptFilter<float>;
+using BlockIirFilter = BlockBiquad<float>;
+#if MYEQ_USE_TPT_FILTERS
+using Filter = SvfFilter;
+#elif MYEQ_USE_BLOCK_IIR_FILTERS
+using Filter = BlockIirFilter;
+#else
+using Filter = BiquadFilter;
+#endif
+using CutFilter = CutFilterOf<Filter>;
+using MonoChain = MonoChainOf<Filter>;
 
 /*similar to how we did the slope enum we do the same for eqTypes.*/
 enum eqTypes
@@ -40,16 +73,43 @@ enum eqTypes
 	HighCut
 };
 
-/*we use the template keyword here so we can pass data types as a parameter
-to make our code more modular, so when expanded, we can use the same function
-for different uses*/
-template<typename Oldcoeff, typename Newcoeff>
-void updateCoeffs(Oldcoeff& oldcoeff, Newcoeff& newcoeff)
+/*installing a set of coefficients is the one thing each topology does differently, the biquad
+copies them straight in, the svf converts them to its own form and the block filter builds its
+weights from them. overloading here keeps the update functions below the same for all of them*/
+inline void updateCoeffs(BiquadFilter& filter, const juce::dsp::IIR::Coefficients<float>& newcoeff)
+{
+	*filter.coefficients = newcoeff;
+}
+inline void updateCoeffs(SvfFilter& filter, const juce::dsp::IIR::Coefficients<float>& newcoeff)
 {
-	oldcoeff = newcoeff;
+	filter.setCoefficients(newcoeff);
 }
-using Coefficients = Filter::CoefficientsPtr;
+inline void updateCoeffs(BlockIirFilter& filter, const juce::dsp::IIR::Coefficients<float>& newcoeff)
+{
+	filter.setCoefficients(newcoeff);
+}
+using Coefficients = juce::dsp::IIR::Coefficients<float>::Ptr;
 Coefficients makePeakFilter(const EqSettings& eqSettings, double samplerate);
+/*the peak is the stage that gets swept, so the svf skips the biquad design (a heap allocated
+set of coefficients it would only convert) and is designed straight into its own form. every
+other topology installs makePeakFilter's coefficients, designed once for all the filters given*/
+template<typename FilterType>
+void updatePeakFilters(std::initializer_list<FilterType*> filters, const EqSettings& eqSettings, double samplerate)
+{
+	if constexpr (std::is_same_v<FilterType, SvfFilter>)
+	{
+		auto peak = SvfFilter::makePeak(samplerate, eqSettings.peakFreq, eqSettings.peakQ,
+										juce::Decibels::decibelsToGain(eqSettings.peakGain));
+		for (auto* filter : filters)
+			filter->setParameters(peak);
+	}
+	else
+	{
+		auto peakCoeffs = makePeakFilter(eqSettings, samplerate);
+		for (auto* filter : filters)
+			updateCoeffs(*filter, *peakCoeffs);
+	}
+}
 /*again using the template, as we use the same function for lowcut and highcut functions,
 our cut filters are comprised of 4 IIR filters, this allows us to use varying degrees of
 a slope*/
@@ -65,16 +125,16 @@ void updateCutFilters(EqType& cutFilter,
 	switch (slope)
 	{
 	case Slope_48:
-		*cutFilter.template get<3>().coefficients = *cutCoeffs[3];
+		updateCoeffs(cutFilter.template get<3>(), *cutCoeffs[3]);
 		cutFilter.template setBypassed<3>(false);
 	case Slope_36:
-		*cutFilter.template get<2>().coefficients = *cutCoeffs[2];
+		updateCoeffs(cutFilter.template get<2>(), *cutCoeffs[2]);
 		cutFilter.template setBypassed<2>(false);
 	case Slope_24:
-		*cutFilter.template get<1>().coefficients = *cutCoeffs[1];
+		updateCoeffs(cutFilter.template get<1>(), *cutCoeffs[1]);
 		cutFilter.template setBypassed<1>(false);
 	case Slope_12:
-		*cutFilter.template get<0>().coefficients = *cutCoeffs[0];
+		updateCoeffs(cutFilter.template get<0>(), *cutCoeffs[0]);
 		cutFilter.template setBypassed<0>(false);
 	}
 }
@@ -140,10 +200,13 @@ public:
 		createParameterLayout();
 	juce::AudioProcessorValueTreeState parameters{ *this, nullptr,
 	"Parameters",createParameterLayout() };
+	//metering on the way in and out, the editor reads their readings
+	LevelMeter inputMeter, outputMeter;
 
 private:
 	//==============================================================================
 	MonoChain leftChain, rightChain;
+	bool metersWereOn{ false };
 	void updatePeakFilter(EqSettings& settings);
 	void updateLowCutFilter(EqSettings& settings);
 	void updateHighCutFilter(EqSettings& settings);
@@ -0,0 +1,206 @@
+/*
+  ==============================================================================
+
+	Topology-preserving-transform state variable filter, the second filter
+	topology the eq chain can be built from (see PluginProcessor.h).
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/*this is andrew simper's linear trapezoidal svf. it runs on cutoff (g), damping (k) and output
+mix (m0, m1, m2). the peak, the stage that gets swept, is designed straight into that form with
+makePeak(), a tan and a divide. everything else takes the same second order IIR::Coefficients
+the juce biquad would (so the butterworth cut designs stay as they are) and converts them. the
+magnitude response is identical either way, but unlike the direct form biquad the structure
+stays stable however fast the coefficients move, so whenever they change we ramp them per
+sample across the next block rather than jumping. only a divide per sample while ramping,
+otherwise it costs about the same as a static biquad.*/
+template<typename SampleType>
+class TptFilter
+{
+public:
+	//the cheap per-sample form, these can be changed every sample
+	struct Parameters
+	{
+		SampleType g{ 0 }, k{ 2 };
+		SampleType m0{ 1 }, m1{ 0 }, m2{ 0 };
+	};
+
+	/*the same bell as IIR::Coefficients::makePeakFilter (gainFactor is linear, the gain at the
+	centre), designed directly: the analog prototype (s^2 + s*A/q + 1)/(s^2 + s/(A*q) + 1) is
+	an svf with k = 1/(A*q) plus k*(A^2-1) of the bandpass mixed back in*/
+	static Parameters makePeak(double sampleRate, SampleType frequency, SampleType q, SampleType gainFactor)
+	{
+		auto a = std::sqrt(juce::jmax(SampleType(0), gainFactor));
+		Parameters p;
+		p.g = SampleType(std::tan(juce::MathConstants<double>::pi * juce::jmax(double(frequency), 2.0) / sampleRate));
+		p.k = 1 / (q * a);
+		p.m0 = 1;
+		p.m1 = p.k * (a * a - 1);
+		p.m2 = 0;
+		return p;
+	}
+
+	//==============================================================================
+	void prepare(const juce::dsp::ProcessSpec& spec)
+	{
+		ic1eq.assign(spec.numChannels, SampleType(0));
+		ic2eq.assign(spec.numChannels, SampleType(0));
+		hasCoefficients = false;
+		reset();
+	}
+
+	void reset()
+	{
+		std::fill(ic1eq.begin(), ic1eq.end(), SampleType(0));
+		std::fill(ic2eq.begin(), ic2eq.end(), SampleType(0));
+		snapToTarget();
+	}
+
+	/*converts a bilinear transform biquad into svf form. with s = (1/g)(z-1)/(z+1) the
+	denominator gives g and k straight from a1 and a2, and the numerator gives how much
+	highpass, bandpass and lowpass to mix back together. a sqrt and a few divides, fine for the
+	cut stages which only change when someone turns a knob.*/
+	void setCoefficients(const juce::dsp::IIR::Coefficients<SampleType>& newCoefficients)
+	{
+		//all our designs are second order sections, first order ones can't go through here
+		jassert(newCoefficients.getFilterOrder() == 2);
+		if (newCoefficients.getFilterOrder() != 2)
+			return;
+
+		auto* c = newCoefficients.getRawCoefficients();
+		auto b0 = c[0], b1 = c[1], b2 = c[2], a1 = c[3], a2 = c[4];
+		//both are positive for any stable biquad
+		auto sum = 1 + a1 + a2;
+		auto diff = 1 - a1 + a2;
+		jassert(sum > 0 && diff > 0);
+
+		Parameters p;
+		p.g = std::sqrt(sum / diff);
+		p.k = 2 * (1 - a2) / (diff * p.g);
+		auto hpGain = (b0 - b1 + b2) / diff;
+		auto bpGain = 2 * (b0 - b2) / (diff * p.g);
+		auto lpGain = (b0 + b1 + b2) / sum;
+		p.m0 = hpGain;
+		p.m1 = bpGain - p.k * hpGain;
+		p.m2 = lpGain - hpGain;
+		setParameters(p);
+	}
+
+	void setParameters(const Parameters& newParameters)
+	{
+		target = newParameters;
+		//the first set after prepare() shouldn't ramp in from a passthrough
+		if (!hasCoefficients)
+		{
+			hasCoefficients = true;
+			snapToTarget();
+			return;
+		}
+		//the processor reinstalls coefficients every block, only ramp when they moved
+		ramping = target.g != current.g || target.k != current.k
+			|| target.m0 != current.m0 || target.m1 != current.m1 || target.m2 != current.m2;
+	}
+
+	void snapToTarget()
+	{
+		current = target;
+		ramping = false;
+		updateGains();
+	}
+
+	//==============================================================================
+	template<typename ProcessContext>
+	void process(const ProcessContext& context) noexcept
+	{
+		auto&& inputBlock = context.getInputBlock();
+		auto&& outputBlock = context.getOutputBlock();
+		auto numChannels = outputBlock.getNumChannels();
+		auto numSamples = outputBlock.getNumSamples();
+		jassert(inputBlock.getNumChannels() == numChannels);
+		jassert(numChannels <= ic1eq.size());
+
+		/*keep the state running while bypassed like juce's IIR::Filter does, the cut stages get
+		switched in and out when the slope changes and shouldn't come back with stale state*/
+		if (context.isBypassed)
+		{
+			snapToTarget();
+			for (size_t ch = 0; ch < numChannels; ++ch)
+			{
+				auto* in = inputBlock.getChannelPointer(ch);
+				auto s1 = ic1eq[ch], s2 = ic2eq[ch];
+				for (size_t i = 0; i < numSamples; ++i)
+					tick(in[i], s1, s2, gainA1, gainA2, gainA3, current.m0, current.m1, current.m2);
+				ic1eq[ch] = s1;
+				ic2eq[ch] = s2;
+			}
+			if (context.usesSeparateInputAndOutputBlocks())
+				outputBlock.copyFrom(inputBlock);
+			return;
+		}
+
+		for (size_t ch = 0; ch < numChannels; ++ch)
+		{
+			auto* in = inputBlock.getChannelPointer(ch);
+			auto* out = outputBlock.getChannelPointer(ch);
+			auto s1 = ic1eq[ch], s2 = ic2eq[ch];
+
+			if (ramping)
+			{
+				auto p = current;
+				auto step = SampleType(1) / SampleType(numSamples);
+				Parameters delta{ (target.g - p.g) * step, (target.k - p.k) * step,
+								  (target.m0 - p.m0) * step, (target.m1 - p.m1) * step,
+								  (target.m2 - p.m2) * step };
+				for (size_t i = 0; i < numSamples; ++i)
+				{
+					p.g += delta.g; p.k += delta.k;
+					p.m0 += delta.m0; p.m1 += delta.m1; p.m2 += delta.m2;
+					auto a1 = 1 / (1 + p.g * (p.g + p.k));
+					auto a2 = p.g * a1;
+					out[i] = tick(in[i], s1, s2, a1, a2, p.g * a2, p.m0, p.m1, p.m2);
+				}
+			}
+			else
+			{
+				for (size_t i = 0; i < numSamples; ++i)
+					out[i] = tick(in[i], s1, s2, gainA1, gainA2, gainA3, current.m0, current.m1, current.m2);
+			}
+
+			ic1eq[ch] = s1;
+			ic2eq[ch] = s2;
+		}
+
+		if (ramping)
+			snapToTarget();
+	}
+
+private:
+	static SampleType tick(SampleType v0, SampleType& s1, SampleType& s2,
+						   SampleType a1, SampleType a2, SampleType a3,
+						   SampleType m0, SampleType m1, SampleType m2) noexcept
+	{
+		auto v3 = v0 - s2;
+		auto v1 = a1 * s1 + a2 * v3;
+		auto v2 = s2 + a2 * s1 + a3 * v3;
+		s1 = 2 * v1 - s1;
+		s2 = 2 * v2 - s2;
+		return m0 * v0 + m1 * v1 + m2 * v2;
+	}
+
+	void updateGains()
+	{
+		gainA1 = 1 / (1 + current.g * (current.g + current.k));
+		gainA2 = current.g * gainA1;
+		gainA3 = current.g * gainA2;
+	}
+
+	Parameters current, target;
+	SampleType gainA1{ 1 }, gainA2{ 0 }, gainA3{ 0 };
+	bool ramping{ false }, hasCoefficients{ false };
+	std::vector<SampleType> ic1eq, ic2eq;
+};
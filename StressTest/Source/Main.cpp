@@ -0,0 +1,578 @@
+/*
+  ==============================================================================
+
+	Instance-density stress harness for the EQ. It adds MyEQAudioProcessor
+	instances in steps, drives all of them from one simulated realtime callback
+	thread (so one core) with randomly automated parameters, and stops once the
+	callback starts missing its deadline. The last step that kept up is the
+	number of instances that fit on a core.
+
+	usage: StressTest [--samplerate=48000] [--blocksize=128] [--start=16]
+					  [--step=16] [--max=1024] [--seconds=3] [--tolerance=0]
+					  [--seed=1] [--editors] [--no-meters] [--check-topologies]
+
+	the callback runs on a realtime thread. if the os refuses one it falls back
+	to a normal high priority thread and says so, then a small --tolerance
+	(e.g. 0.001) stops one scheduling hiccup from ending a step.
+
+	--editors opens every instance's editor in a desktop window and keeps the
+	message thread looping while the callback thread runs, like a session with
+	plugin windows open. --no-meters switches the input/output metering off in
+	every instance, run with and without it to see what the meters cost. with
+	the meters on, one LevelMeter is also timed on its own first and its cost per
+	block and share of the deadline printed.
+
+	--check-topologies doesn't run the stress test, it renders noise through the
+	normal biquad chain and through the tpt svf (TptFilter.h) and block iir
+	(BlockBiquad.h) chains, for random settings and for peak freq sweeps, on one
+	channel, in blocks cycling through 1, 7, 127 and 128 samples. it reports how
+	far apart they are, how fast each one ran at --blocksize, and exits non-zero
+	if either topology doesn't match.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../Source/PluginProcessor.h"
+
+#if JUCE_WINDOWS
+ #include <windows.h>
+ #include <psapi.h>
+ #pragma comment(lib, "psapi.lib")
+#elif JUCE_MAC
+ #include <mach/mach.h>
+#elif JUCE_LINUX
+ #include <unistd.h>
+#endif
+
+//==============================================================================
+struct StressSettings
+{
+	double sampleRate{ 48000.0 };
+	int blockSize{ 128 };
+	int startInstances{ 16 }, stepInstances{ 16 }, maxInstances{ 1024 };
+	double secondsPerStep{ 3.0 };
+	//fraction of blocks allowed to overrun before a step counts as failed
+	double missTolerance{ 0.0 };
+	juce::int64 seed{ 1 };
+	bool openEditors{ false };
+	bool metersOn{ true };
+	bool checkTopologies{ false };
+};
+
+static StressSettings parseSettings(const juce::ArgumentList& args)
+{
+	StressSettings s;
+	auto option = [&args](juce::StringRef name, const juce::String& fallback)
+	{
+		auto value = args.getValueForOption(name);
+		return value.isEmpty() ? fallback : value;
+	};
+	s.sampleRate = option("--samplerate", juce::String(s.sampleRate)).getDoubleValue();
+	s.blockSize = option("--blocksize", juce::String(s.blockSize)).getIntValue();
+	s.startInstances = option("--start", juce::String(s.startInstances)).getIntValue();
+	s.stepInstances = option("--step", juce::String(s.stepInstances)).getIntValue();
+	s.maxInstances = option("--max", juce::String(s.maxInstances)).getIntValue();
+	s.secondsPerStep = option("--seconds", juce::String(s.secondsPerStep)).getDoubleValue();
+	s.missTolerance = option("--tolerance", juce::String(s.missTolerance)).getDoubleValue();
+	s.seed = option("--seed", juce::String(s.seed)).getLargeIntValue();
+	s.openEditors = args.containsOption("--editors");
+	s.metersOn = !args.containsOption("--no-meters");
+	s.checkTopologies = args.containsOption("--check-topologies");
+
+	s.blockSize = juce::jmax(1, s.blockSize);
+	s.startInstances = juce::jmax(1, s.startInstances);
+	s.stepInstances = juce::jmax(1, s.stepInstances);
+	return s;
+}
+
+//resident set size of the whole process, used to work out memory per instance
+static juce::int64 getResidentBytes()
+{
+#if JUCE_WINDOWS
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return (juce::int64)counters.WorkingSetSize;
+#elif JUCE_MAC
+	mach_task_basic_info info;
+	mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+	if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count) == KERN_SUCCESS)
+		return (juce::int64)info.resident_size;
+#elif JUCE_LINUX
+	juce::StringArray fields;
+	fields.addTokens(juce::File("/proc/self/statm").loadFileAsString(), " ", {});
+	if (fields.size() > 1)
+		return fields[1].getLargeIntValue() * (juce::int64)sysconf(_SC_PAGESIZE);
+#endif
+	return 0;
+}
+
+//==============================================================================
+/*one plugin instance plus the automation that gets played into it. each parameter
+gets its own slow lfo with a random rate, depth and centre, and some are left
+static, so no two instances are doing the same work.*/
+struct AutomatedInstance
+{
+	AutomatedInstance(const StressSettings& settings, juce::Random& random)
+		: processor(std::make_unique<MyEQAudioProcessor>())
+	{
+		processor->setPlayConfigDetails(2, 2, settings.sampleRate, settings.blockSize);
+		processor->prepareToPlay(settings.sampleRate, settings.blockSize);
+		buffer.setSize(2, settings.blockSize);
+
+		auto blocksPerSecond = settings.sampleRate / settings.blockSize;
+		for (auto param : processor->getParameters())
+		{
+			Lane lane;
+			lane.param = param;
+			lane.centre = random.nextFloat();
+			//the meter switch isn't something anyone automates, it stays where we put it
+			auto* withID = dynamic_cast<juce::AudioProcessorParameterWithID*>(param);
+			if (withID != nullptr && withID->paramID == "Meters On")
+				lane.centre = settings.metersOn ? 1.f : 0.f;
+			else if (random.nextBool())
+			{
+				lane.depth = 0.5f * random.nextFloat();
+				//somewhere between 0.05Hz and 8Hz
+				auto rate = 0.05 * std::pow(160.0, random.nextDouble());
+				lane.increment = float(juce::MathConstants<double>::twoPi * rate / blocksPerSecond);
+				lane.phase = random.nextFloat() * juce::MathConstants<float>::twoPi;
+			}
+			param->setValueNotifyingHost(lane.centre);
+			lanes.push_back(lane);
+		}
+	}
+
+	void openEditor()
+	{
+		editor.reset(processor->createEditorIfNeeded());
+		if (editor != nullptr)
+		{
+			editor->setVisible(true);
+			editor->addToDesktop(juce::ComponentPeer::windowHasTitleBar);
+		}
+	}
+
+	void renderBlock(const juce::AudioBuffer<float>& input, int inputOffset)
+	{
+		for (auto& lane : lanes)
+		{
+			if (lane.depth == 0.f)
+				continue;
+			lane.phase += lane.increment;
+			if (lane.phase > juce::MathConstants<float>::twoPi)
+				lane.phase -= juce::MathConstants<float>::twoPi;
+			auto value = lane.centre + lane.depth * std::sin(lane.phase);
+			lane.param->setValueNotifyingHost(juce::jlimit(0.f, 1.f, value));
+		}
+
+		//fresh input every block, like a host would hand us
+		for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+			buffer.copyFrom(ch, 0, input, ch, inputOffset, buffer.getNumSamples());
+		processor->processBlock(buffer, midi);
+	}
+
+	struct Lane
+	{
+		juce::AudioProcessorParameter* param{ nullptr };
+		float centre{ 0.f }, depth{ 0.f }, phase{ 0.f }, increment{ 0.f };
+	};
+
+	std::unique_ptr<MyEQAudioProcessor> processor;
+	//declared after the processor so it is deleted first
+	std::unique_ptr<juce::AudioProcessorEditor> editor;
+	std::vector<Lane> lanes;
+	juce::AudioBuffer<float> buffer;
+	juce::MidiBuffer midi;
+};
+
+//==============================================================================
+struct StepResult
+{
+	int instances{ 0 };
+	int blocks{ 0 }, misses{ 0 };
+	double meanLoad{ 0 }, worstLoad{ 0 };
+};
+
+/*stands in for the host's audio callback. it wakes up once per block period, renders
+every instance back to back and checks the time taken against the period. blocks
+that overrun are counted as deadline misses and the schedule is resynced.*/
+class CallbackThread : public juce::Thread
+{
+public:
+	CallbackThread(std::vector<std::unique_ptr<AutomatedInstance>>& instancesToRun,
+				   const juce::AudioBuffer<float>& inputNoise,
+				   const StressSettings& settings)
+		: juce::Thread("StressTest callback"),
+		instances(instancesToRun),
+		noise(inputNoise),
+		blockSize(settings.blockSize),
+		periodSeconds(settings.blockSize / settings.sampleRate)
+	{
+		auto totalBlocks = int(settings.secondsPerStep / periodSeconds);
+		//the first quarter second is page faults and cold caches, don't count it
+		warmupBlocks = juce::jmin(totalBlocks / 2, int(0.25 / periodSeconds));
+		measuredBlocks = juce::jmax(1, totalBlocks - warmupBlocks);
+	}
+
+	void run() override
+	{
+		auto ticksPerSecond = juce::Time::getHighResolutionTicksPerSecond();
+		auto periodTicks = juce::int64(periodSeconds * double(ticksPerSecond));
+		auto nextDeadline = juce::Time::getHighResolutionTicks() + periodTicks;
+		int inputOffset = 0;
+		double loadSum = 0;
+
+		for (int i = 0; i < warmupBlocks + measuredBlocks && !threadShouldExit(); ++i)
+		{
+			auto start = juce::Time::getHighResolutionTicks();
+			for (auto& instance : instances)
+				instance->renderBlock(noise, inputOffset);
+			auto end = juce::Time::getHighResolutionTicks();
+
+			inputOffset += blockSize;
+			if (inputOffset + blockSize > noise.getNumSamples())
+				inputOffset = 0;
+
+			if (i >= warmupBlocks)
+			{
+				auto load = double(end - start) / double(periodTicks);
+				loadSum += load;
+				result.worstLoad = juce::jmax(result.worstLoad, load);
+				++result.blocks;
+				if (end > nextDeadline)
+					++result.misses;
+			}
+
+			if (end > nextDeadline)
+			{
+				nextDeadline = end + periodTicks;
+				continue;
+			}
+			//sleep for most of the gap and spin the rest, sleep() is too coarse on its own
+			auto msLeft = juce::Time::highResolutionTicksToSeconds(nextDeadline - end) * 1000.0;
+			if (msLeft > 2.0)
+				juce::Thread::sleep(int(msLeft) - 1);
+			while (juce::Time::getHighResolutionTicks() < nextDeadline)
+				juce::Thread::yield();
+			nextDeadline += periodTicks;
+		}
+
+		result.instances = int(instances.size());
+		result.meanLoad = result.blocks > 0 ? loadSum / result.blocks : 0.0;
+	}
+
+	StepResult result;
+
+private:
+	std::vector<std::unique_ptr<AutomatedInstance>>& instances;
+	const juce::AudioBuffer<float>& noise;
+	int blockSize;
+	double periodSeconds;
+	int warmupBlocks{ 0 }, measuredBlocks{ 0 };
+};
+
+//==============================================================================
+//same as the processor's update functions but for any chain, so every topology gets identical settings
+template<typename FilterType>
+static void installSettings(MonoChainOf<FilterType>& chain, EqSettings eqSettings, double sampleRate)
+{
+	updatePeakFilters({ &chain.template get<eqTypes::Peak>() }, eqSettings, sampleRate);
+	auto lowCutCoeffs = makeLowCutFilter(eqSettings, sampleRate);
+	updateCutFilters(chain.template get<eqTypes::LowCut>(), lowCutCoeffs, eqSettings.lowCutSlope);
+	auto highCutCoeffs = makeHighCutFilter(eqSettings, sampleRate);
+	updateCutFilters(chain.template get<eqTypes::HighCut>(), highCutCoeffs, eqSettings.highCutSlope);
+}
+
+/*runs channel 0 through the chain in place a block at a time, cycling through blockSizes,
+calling beforeBlock with the start of each block first (that's where automation goes), returns
+the seconds it took*/
+template<typename FilterType, typename BeforeBlock>
+static double renderMono(MonoChainOf<FilterType>& chain, juce::AudioBuffer<float>& buffer,
+						 const std::vector<int>& blockSizes, BeforeBlock&& beforeBlock)
+{
+	juce::dsp::AudioBlock<float> channel = juce::dsp::AudioBlock<float>(buffer).getSingleChannelBlock(0);
+	auto start = juce::Time::getHighResolutionTicks();
+	size_t next = 0;
+	for (int pos = 0, count = 0; pos < buffer.getNumSamples(); pos += count)
+	{
+		count = juce::jmin(blockSizes[next++ % blockSizes.size()], buffer.getNumSamples() - pos);
+		beforeBlock(pos);
+		auto block = channel.getSubBlock((size_t)pos, (size_t)count);
+		chain.process(juce::dsp::ProcessContextReplacing<float>(block));
+	}
+	return juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+}
+
+static EqSettings randomEqSettings(juce::Random& random)
+{
+	EqSettings eqSettings;
+	eqSettings.lowCutFreq = juce::mapToLog10(random.nextFloat(), 20.f, 20000.f);
+	eqSettings.highCutFreq = juce::mapToLog10(random.nextFloat(), 20.f, 20000.f);
+	eqSettings.peakFreq = juce::mapToLog10(random.nextFloat(), 20.f, 20000.f);
+	eqSettings.peakGain = juce::jmap(random.nextFloat(), -24.f, 24.f);
+	eqSettings.peakQ = juce::jmap(random.nextFloat(), 0.1f, 10.f);
+	eqSettings.lowCutSlope = static_cast<Slope>(random.nextInt(4));
+	eqSettings.highCutSlope = static_cast<Slope>(random.nextInt(4));
+	return eqSettings;
+}
+
+/*worst sample difference between start and end, in dB relative to the reference's rms over
+the same range. a nan or inf anywhere counts as infinitely bad rather than being skipped*/
+static double differenceDb(const juce::AudioBuffer<float>& reference, const juce::AudioBuffer<float>& other,
+						   int start, int end)
+{
+	double maxError = 0.0;
+	for (int i = start; i < end; ++i)
+	{
+		auto difference = std::abs(double(reference.getSample(0, i)) - double(other.getSample(0, i)));
+		if (!(difference <= maxError))
+			maxError = std::isfinite(difference) ? difference : std::numeric_limits<double>::infinity();
+	}
+	auto rms = double(reference.getRMSLevel(0, start, end - start));
+	//a silent reference just gets the absolute error
+	return juce::Decibels::gainToDecibels(maxError / juce::jmax(rms, 1.0e-6), -300.0);
+}
+
+/*renders noise through the normal biquad chain and a chain built from FilterType and compares
+them. the blocks cycle through 1, 7, 127 and 128 samples, so block filters get their leftover
+samples and the hand over between blocks exercised as well as whole blocks. static trials use
+random settings and should match to rounding, they're rendered again at the configured block
+size for the timing. sweep trials also sweep
+Peak Freq from 200Hz to 5kHz and back over the first half, one install per block like the
+processor, then hold it. topologies may legitimately handle the moves differently (the svf
+ramps its coefficients across each block, the biquad jumps), so a sample for sample match isn't
+expected there: the level during the sweep has to agree and the outputs have to come back
+together once it stops.*/
+template<typename FilterType>
+static bool runTopologyCheck(const juce::String& name, const StressSettings& settings,
+							 const juce::AudioBuffer<float>& noise)
+{
+	const int staticTrials = 50, sweepTrials = 10;
+	//the float biquad's own rounding is most of the difference, so anything up here is a real bug
+	const double failAboveDb = -50.0, sweepLevelToleranceDb = 0.5;
+	//every topology gets the same settings
+	juce::Random random(settings.seed);
+	const std::vector<int> checkBlockSizes{ 1, 7, 127, 128 }, timedBlockSizes{ settings.blockSize };
+	juce::dsp::ProcessSpec spec{ settings.sampleRate, (juce::uint32)juce::jmax(settings.blockSize, 128), 1 };
+	auto numSamples = noise.getNumSamples();
+
+	double worstStaticDb = -300.0, worstSweepLevelDb = 0.0, worstSweepTailDb = -300.0;
+	double referenceSeconds = 0.0, topologySeconds = 0.0;
+
+	for (int trial = 0; trial < staticTrials + sweepTrials; ++trial)
+	{
+		auto sweeping = trial >= staticTrials;
+		auto eqSettings = randomEqSettings(random);
+
+		auto reference = std::make_unique<MonoChainOf<BiquadFilter>>();
+		auto topology = std::make_unique<MonoChainOf<FilterType>>();
+		reference->prepare(spec);
+		topology->prepare(spec);
+		installSettings(*reference, eqSettings, settings.sampleRate);
+		installSettings(*topology, eqSettings, settings.sampleRate);
+
+		auto sweepAt = [&](int pos, auto& chain)
+		{
+			if (!sweeping)
+				return;
+			auto phase = juce::jmin(1.0, pos / (0.5 * numSamples));
+			auto sweep = eqSettings;
+			sweep.peakFreq = float(200.0 * std::pow(25.0, 0.5 - 0.5 * std::cos(juce::MathConstants<double>::twoPi * phase)));
+			installSettings(chain, sweep, settings.sampleRate);
+		};
+
+		juce::AudioBuffer<float> referenceOut(1, numSamples), topologyOut(1, numSamples);
+		referenceOut.copyFrom(0, 0, noise, 0, 0, numSamples);
+		topologyOut.copyFrom(0, 0, noise, 0, 0, numSamples);
+		renderMono(*reference, referenceOut, checkBlockSizes, [&](int pos) { sweepAt(pos, *reference); });
+		renderMono(*topology, topologyOut, checkBlockSizes, [&](int pos) { sweepAt(pos, *topology); });
+
+		if (!sweeping)
+		{
+			worstStaticDb = juce::jmax(worstStaticDb, differenceDb(referenceOut, topologyOut, 0, numSamples));
+
+			//same again from fresh chains at the configured block size, timed
+			reference->reset();
+			topology->reset();
+			referenceOut.copyFrom(0, 0, noise, 0, 0, numSamples);
+			topologyOut.copyFrom(0, 0, noise, 0, 0, numSamples);
+			referenceSeconds += renderMono(*reference, referenceOut, timedBlockSizes, [](int) {});
+			topologySeconds += renderMono(*topology, topologyOut, timedBlockSizes, [](int) {});
+			worstStaticDb = juce::jmax(worstStaticDb, differenceDb(referenceOut, topologyOut, 0, numSamples));
+			continue;
+		}
+
+		auto half = numSamples / 2;
+		auto levelDb = juce::Decibels::gainToDecibels(topologyOut.getRMSLevel(0, 0, half), -300.f)
+			- juce::Decibels::gainToDecibels(referenceOut.getRMSLevel(0, 0, half), -300.f);
+		//nan levels have to fail too
+		if (!(std::abs(levelDb) <= std::abs(worstSweepLevelDb)))
+			worstSweepLevelDb = std::isfinite(levelDb) ? double(levelDb) : std::numeric_limits<double>::infinity();
+		worstSweepTailDb = juce::jmax(worstSweepTailDb, differenceDb(referenceOut, topologyOut, numSamples * 3 / 4, numSamples));
+	}
+
+	auto passed = worstStaticDb < failAboveDb && worstSweepTailDb < failAboveDb
+		&& std::abs(worstSweepLevelDb) < sweepLevelToleranceDb;
+	auto timedSamples = double(staticTrials) * numSamples;
+	std::cout << name << " vs biquad chain, " << staticTrials << " random settings + " << sweepTrials
+		<< " peak freq sweeps, blocks of 1/7/127/128 samples: " << (passed ? "ok" : "FAILED") << std::endl
+		<< "  worst static difference: " << juce::String(worstStaticDb, 1) << " dB below output rms" << std::endl
+		<< "  worst sweep level difference: " << juce::String(worstSweepLevelDb, 3) << " dB, worst difference after the sweep: "
+		<< juce::String(worstSweepTailDb, 1) << " dB" << std::endl
+		<< "  at " << settings.blockSize << " samples per block, biquad chain: " << juce::String(1.0e9 * referenceSeconds / timedSamples, 2) << " ns/sample, "
+		<< name << " chain: " << juce::String(1.0e9 * topologySeconds / timedSamples, 2) << " ns/sample ("
+		<< juce::String(referenceSeconds / juce::jmax(topologySeconds, 1.0e-12), 2) << "x)" << std::endl;
+	return passed;
+}
+
+/*times one LevelMeter on its own over the noise at the configured block size, the way the
+processor calls it (an instance runs two, input and output). best of a few passes so the
+figure is the meter's cost rather than the scheduler's*/
+static void reportMeterCost(const StressSettings& settings, const juce::AudioBuffer<float>& noise)
+{
+	const int passes = 5;
+	auto input = noise;
+	LevelMeter meter;
+	meter.prepare(settings.sampleRate, settings.blockSize, input.getNumChannels());
+
+	double bestSeconds = std::numeric_limits<double>::max();
+	int numBlocks = 0;
+	for (int pass = 0; pass < passes; ++pass)
+	{
+		numBlocks = 0;
+		auto start = juce::Time::getHighResolutionTicks();
+		for (int pos = 0; pos < input.getNumSamples(); pos += settings.blockSize, ++numBlocks)
+		{
+			juce::AudioBuffer<float> block(input.getArrayOfWritePointers(), input.getNumChannels(), pos,
+										   juce::jmin(settings.blockSize, input.getNumSamples() - pos));
+			meter.process(block);
+		}
+		bestSeconds = juce::jmin(bestSeconds, juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start));
+	}
+
+	auto nsPerBlock = 1.0e9 * bestSeconds / numBlocks;
+	auto deadlineNs = 1.0e9 * settings.blockSize / settings.sampleRate;
+	std::cout << "  one level meter, " << input.getNumChannels() << " channels: "
+		<< juce::String(nsPerBlock, 0) << " ns/block, " << juce::String(100.0 * nsPerBlock / deadlineNs, 3)
+		<< "% of the deadline (two per instance)" << std::endl;
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+	juce::ScopedJuceInitialiser_GUI juceInit;
+	auto settings = parseSettings(juce::ArgumentList(argc, argv));
+	juce::Random random(settings.seed);
+
+	//one second of pink-ish noise shared by every instance as its input
+	juce::AudioBuffer<float> noise(2, int(settings.sampleRate));
+	for (int ch = 0; ch < noise.getNumChannels(); ++ch)
+	{
+		float state = 0.f;
+		for (int i = 0; i < noise.getNumSamples(); ++i)
+		{
+			state = 0.97f * state + 0.03f * (random.nextFloat() * 2.f - 1.f);
+			noise.setSample(ch, i, 4.f * state);
+		}
+	}
+
+	if (settings.checkTopologies)
+	{
+		auto svfPassed = runTopologyCheck<SvfFilter>("tpt svf", settings, noise);
+		std::cout << "(block iir runs " << BlockIirFilter::blockLength << " samples per step in "
+			<< BlockIirFilter::lanes << "-lane registers)" << std::endl;
+		auto blockPassed = runTopologyCheck<BlockIirFilter>("block iir", settings, noise);
+		return svfPassed && blockPassed ? 0 : 1;
+	}
+
+	std::cout << "myEQ instance-density stress test" << std::endl
+		<< "  " << settings.sampleRate << " Hz, " << settings.blockSize << " samples per block ("
+		<< juce::String(1000.0 * settings.blockSize / settings.sampleRate, 3) << " ms deadline), "
+		<< settings.secondsPerStep << " s per step"
+		<< (settings.openEditors ? ", editors open" : "")
+		<< (settings.metersOn ? "" : ", meters off") << std::endl;
+	if (settings.metersOn)
+		reportMeterCost(settings, noise);
+	std::cout << std::endl << "  instances   mean load   worst load   misses/blocks" << std::endl;
+
+	std::vector<std::unique_ptr<AutomatedInstance>> instances;
+	auto baselineBytes = getResidentBytes();
+	juce::int64 processorBytes = 0, editorBytes = 0;
+	double processorMs = 0, editorMs = 0;
+	StepResult lastGood;
+	bool failed = false;
+
+	for (int target = settings.startInstances; target <= settings.maxInstances; target += settings.stepInstances)
+	{
+		//construction (processor + prepareToPlay) and editor opening are timed as well
+		auto before = getResidentBytes();
+		auto startMs = juce::Time::getMillisecondCounterHiRes();
+		std::vector<AutomatedInstance*> added;
+		while ((int)instances.size() < target)
+		{
+			instances.push_back(std::make_unique<AutomatedInstance>(settings, random));
+			added.push_back(instances.back().get());
+		}
+		processorMs += juce::Time::getMillisecondCounterHiRes() - startMs;
+		auto afterProcessors = getResidentBytes();
+		processorBytes += afterProcessors - before;
+
+		if (settings.openEditors)
+		{
+			startMs = juce::Time::getMillisecondCounterHiRes();
+			for (auto instance : added)
+				instance->openEditor();
+			editorMs += juce::Time::getMillisecondCounterHiRes() - startMs;
+			editorBytes += getResidentBytes() - afterProcessors;
+		}
+
+		CallbackThread callback(instances, noise, settings);
+		/*a proper realtime thread like a host's audio callback, otherwise ordinary scheduling
+		hiccups show up as deadline misses. if the os won't give us one (no rtprio on linux, say)
+		fall back to the highest normal priority and say so, --tolerance can soak up the noise*/
+		auto periodMs = 1000.0 * settings.blockSize / settings.sampleRate;
+		if (!callback.startRealtimeThread(juce::Thread::RealtimeOptions{}.withPeriodMs(periodMs)))
+		{
+			std::cout << "  (couldn't get a realtime thread, misses may include scheduler noise)" << std::endl;
+			callback.startThread(juce::Thread::Priority::highest);
+		}
+		//keep the message thread turning over so timers, attachments and repaints run
+		while (callback.isThreadRunning())
+			juce::MessageManager::getInstance()->runDispatchLoopUntil(10);
+
+		auto& r = callback.result;
+		std::cout << "  " << juce::String(r.instances).paddedLeft(' ', 9)
+			<< juce::String(juce::String(100.0 * r.meanLoad, 1) + "%").paddedLeft(' ', 12)
+			<< juce::String(juce::String(100.0 * r.worstLoad, 1) + "%").paddedLeft(' ', 13)
+			<< juce::String(juce::String(r.misses) + "/" + juce::String(r.blocks)).paddedLeft(' ', 16)
+			<< std::endl;
+
+		if (r.blocks == 0 || double(r.misses) / double(r.blocks) > settings.missTolerance)
+		{
+			failed = true;
+			break;
+		}
+		lastGood = r;
+	}
+
+	auto count = juce::jmax(1, (int)instances.size());
+	std::cout << std::endl;
+	if (lastGood.instances > 0)
+		std::cout << "max instances per core before deadline misses: " << lastGood.instances
+			<< (failed ? "" : " (hit --max, raise it to go further)") << std::endl;
+	else
+		std::cout << "missed deadlines at the first step, lower --start" << std::endl;
+	std::cout << "memory per instance: " << juce::File::descriptionOfSizeInBytes(processorBytes / count) << std::endl;
+	std::cout << "construction per instance: " << juce::String(processorMs / count, 3) << " ms" << std::endl;
+	if (settings.openEditors)
+	{
+		std::cout << "memory per open editor: " << juce::File::descriptionOfSizeInBytes(editorBytes / count) << std::endl;
+		std::cout << "editor open per instance: " << juce::String(editorMs / count, 3) << " ms" << std::endl;
+	}
+	std::cout << "process resident size: " << juce::File::descriptionOfSizeInBytes(getResidentBytes())
+		<< " (" << juce::File::descriptionOfSizeInBytes(baselineBytes) << " before any instances)" << std::endl;
+
+	instances.clear();
+	return lastGood.instances > 0 ? 0 : 1;
+}